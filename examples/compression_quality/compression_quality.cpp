@@ -0,0 +1,40 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <KleiLib/Mipmap.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+  // Compresses the same image with every DXT format and quality, to compare their speed and error
+  std::string inputImagePath = argc > 1 ? argv[1] : "wurt.png";
+  bool preMultiplyAlpha = false;
+
+  Image::Image8 image(inputImagePath);
+
+  using PixelFormat = KleiLib::Mipmap::PixelFormat;
+  using Quality = KleiLib::Mipmap::Quality;
+  const std::pair<PixelFormat, const char*> pixelFormats[] = {
+    {PixelFormat::DXT1, "DXT1"}, {PixelFormat::DXT3, "DXT3"}, {PixelFormat::DXT5, "DXT5"}
+  };
+  const std::pair<Quality, const char*> qualities[] = {
+    {Quality::Fast, "fast"}, {Quality::Normal, "normal"}, {Quality::High, "high"}
+  };
+
+  std::cout << inputImagePath << ": " << image.width() << "x" << image.height() << "\n"
+            << std::fixed << std::setprecision(2);
+
+  for (auto [pixelFormat, formatName] : pixelFormats) {
+    for (auto [quality, qualityName] : qualities) {
+      auto start = std::chrono::steady_clock::now();
+      KleiLib::Mipmap mip(image, pixelFormat, preMultiplyAlpha, quality);
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+      auto error = mip.measureError(image, pixelFormat, preMultiplyAlpha);
+      std::cout << formatName << " " << std::left << std::setw(7) << qualityName << std::right << std::setw(10)
+                << elapsed.count() << " ms  RMSE " << std::setw(6) << error.rmse << "  PSNR " << error.psnr << " dB\n";
+    }
+  }
+}
@@ -0,0 +1,34 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <TexConverter/Converter.hpp>
+#include <iostream>
+#include <string>
+
+int main() {
+  std::string inputImagePath = "wurt.png";
+  std::string outputTexPath = "wurt.tex";
+  auto pixelFormat = TexConverter::PixelFormat::DXT5;
+  auto interpolationMode = TexConverter::MipmapFilter::Bicubic;
+  auto textureType = TexConverter::TextureType::TwoD;
+  bool generateMipmaps = true;
+  bool preMultiplyAlpha = true;
+
+  // 0 threads means one per hardware thread
+  TexConverter::ThreadPool threadPool(0);
+  std::cout << "Converting " << inputImagePath << " on " << threadPool.size() << " threads...\n";
+
+  TexConverter::convertImageToTex(
+    inputImagePath,
+    outputTexPath,
+    pixelFormat,
+    interpolationMode,
+    textureType,
+    generateMipmaps,
+    preMultiplyAlpha,
+    &threadPool
+  );
+
+  std::cout << "Converted " << inputImagePath << ".\n"
+            << "Saved to " << outputTexPath << ".\n";
+}
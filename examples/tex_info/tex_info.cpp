@@ -0,0 +1,25 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <KleiLib/TexFileReader.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  // Only the header and mip table of each file are read, the pixel data is never touched
+  std::vector<std::string> inputTexPaths(argv + 1, argv + argc);
+  if (inputTexPaths.empty()) { inputTexPaths.emplace_back("wurt.tex"); }
+
+  for (const auto& path : inputTexPaths) {
+    KleiLib::TexFileReader tex(path);
+
+    std::cout << path << ": pixel format " << int(tex.pixelFormat()) << ", texture type " << int(tex.textureType())
+              << ", " << tex.mipCount() << " mips\n";
+
+    for (size_t level = 0; level < tex.mipCount(); level++) {
+      const auto& mip = tex.mipInfo(level);
+      std::cout << "  " << level << ": " << mip.width << "x" << mip.height << ", " << mip.datasize << " bytes\n";
+    }
+  }
+}
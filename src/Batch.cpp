@@ -0,0 +1,356 @@
+#include "TexConverter/Batch.hpp"
+
+#include <KleiLib/MappedFile.h>
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace TexConverter
+{
+  namespace fs = std::filesystem;
+
+  namespace
+  {
+    // Bump whenever the converter's output or the cache format changes, so files produced by an older version get
+    // converted again
+    constexpr uint32_t CacheVersion = 2;
+    constexpr const char* CacheMagic = "texconverter-cache";
+
+    struct CacheEntry {
+      uint64_t inputHash;
+      uint64_t optionsHash;
+      // Of the input when it was hashed, an unchanged size and modification time skip hashing it again
+      uint64_t inputSize;
+      uint64_t inputTime;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+      return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    uint64_t hashOptions(const ConversionOptions& options) {
+      std::array<uint8_t, 10> key = {
+        uint8_t(CacheVersion),
+        uint8_t(CacheVersion >> 8),
+        uint8_t(CacheVersion >> 16),
+        uint8_t(CacheVersion >> 24),
+        uint8_t(options.pixelFormat),
+        uint8_t(options.interpolationMode),
+        uint8_t(options.textureType),
+        uint8_t(options.generateMipmaps),
+        uint8_t(options.preMultiplyAlpha),
+        uint8_t(options.quality)
+      };
+
+      return hashBytes(key.data(), key.size());
+    }
+
+    // One "<input hash> <options hash> <input size> <input time> <output path>" line per output, after a version line
+    std::map<std::string, CacheEntry> loadCache(const std::string& cacheFile) {
+      std::map<std::string, CacheEntry> cache;
+      std::ifstream in(cacheFile);
+
+      std::string magic;
+      uint32_t version = 0;
+      if (!(in >> magic >> version) || magic != CacheMagic || version != CacheVersion) { return cache; }
+
+      CacheEntry entry{};
+      std::string outputFile;
+      while (in >> std::hex >> entry.inputHash >> entry.optionsHash >> entry.inputSize >> entry.inputTime &&
+             std::getline(in >> std::ws, outputFile)) {
+        cache[outputFile] = entry;
+      }
+
+      return cache;
+    }
+
+    void saveCache(const std::string& cacheFile, const std::map<std::string, CacheEntry>& cache) {
+      // Written next to the old one and swapped in, so an interrupted run can't leave a truncated cache behind
+      auto tempFile = cacheFile + ".tmp";
+      {
+        std::ofstream out(tempFile, std::ios::trunc);
+        out << CacheMagic << " " << CacheVersion << "\n" << std::hex << std::setfill('0');
+
+        for (const auto& [outputFile, entry] : cache) {
+          out << std::setw(16) << entry.inputHash << " " << std::setw(16) << entry.optionsHash << " " << entry.inputSize
+              << " " << entry.inputTime << " " << outputFile << "\n";
+        }
+
+        if (!out) { throw std::runtime_error("Could not write " + tempFile); }
+      }
+
+      fs::rename(tempFile, cacheFile);
+    }
+
+    bool isSupportedImage(const fs::path& path) {
+      static const std::array<std::string, 12> extensions = {
+        ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif", ".hdr", ".pic", ".pnm", ".ppm", ".pgm"
+      };
+
+      auto extension = path.extension().string();
+      std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return char(std::tolower(c));
+      });
+
+      return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }
+
+    // A job whose output exists and whose options, input size and modification time match its cache entry is
+    // skipped without reading the input. Otherwise the input file is mapped once, hashed (skipping the job if only
+    // its time changed) and then decoded from memory, so it is only read from disk once.
+    void runJob(
+      const BatchJob& job,
+      BatchJobResult& result,
+      ThreadPool& threadPool,
+      Image::BufferPool& bufferPool,
+      bool sizePoolToImages,
+      const std::map<std::string, CacheEntry>* cache,
+      CacheEntry& cacheEntry
+    ) {
+      auto start = Clock::now();
+      // Taken before reading, so an input modified during the conversion is hashed again by the next run
+      cacheEntry.optionsHash = hashOptions(job.options);
+      cacheEntry.inputSize = fs::file_size(job.inputFile);
+      // The file clock's epoch may be in the future, its count is stored as its unsigned bit pattern
+      cacheEntry.inputTime = uint64_t(fs::last_write_time(job.inputFile).time_since_epoch().count());
+
+      const CacheEntry* cached = nullptr;
+      if (cache && fs::exists(job.outputFile)) {
+        auto found = cache->find(job.outputFile);
+        if (found != cache->end() && found->second.optionsHash == cacheEntry.optionsHash) { cached = &found->second; }
+      }
+
+      if (cached && cached->inputSize == cacheEntry.inputSize && cached->inputTime == cacheEntry.inputTime) {
+        cacheEntry.inputHash = cached->inputHash;
+        result.hashTime = millisecondsSince(start);
+        result.status = BatchJobResult::Status::Skipped;
+        return;
+      }
+
+      KleiLib::MappedFile input(job.inputFile);
+      auto bytes = input.bytes();
+
+      cacheEntry.inputHash = hashBytes(bytes.data(), bytes.size());
+      result.hashTime = millisecondsSince(start);
+
+      if (cached && cached->inputHash == cacheEntry.inputHash) {
+        result.status = BatchJobResult::Status::Skipped;
+        return;
+      }
+
+      start = Clock::now();
+      // stb_image takes the length as an int
+      if (bytes.size() > size_t(INT_MAX)) {
+        throw std::runtime_error("Input is too large to decode (" + std::to_string(bytes.size()) + " bytes)");
+      }
+
+      int width, height, channels;
+      auto* pixels = stbi_load_from_memory(bytes.data(), int(bytes.size()), &width, &height, &channels, 0);
+      if (pixels == nullptr) { throw std::runtime_error(stbi_failure_reason()); }
+
+      Image::Image8 image(pixels, width, height, channels);
+      result.decodeTime = millisecondsSince(start);
+      auto pixelBytes = uint64_t(width) * height * channels;
+      result.stats.record({ConversionStats::Stage::DecodeImage, -1, result.decodeTime, pixelBytes});
+
+      if (sizePoolToImages) { bufferPool.growMaxCachedBytes(size_t(width) * height * 4 * 4 / 3); }
+
+      start = Clock::now();
+      auto outputDirectory = fs::path(job.outputFile).parent_path();
+      if (!outputDirectory.empty()) { fs::create_directories(outputDirectory); }
+
+      const auto& options = job.options;
+      convertImageToTex(
+        image,
+        job.outputFile,
+        options.pixelFormat,
+        options.interpolationMode,
+        options.textureType,
+        options.generateMipmaps,
+        options.preMultiplyAlpha,
+        &threadPool,
+        &bufferPool,
+        &result.stats,
+        options.quality
+      );
+      result.convertTime = millisecondsSince(start);
+      result.status = BatchJobResult::Status::Converted;
+    }
+
+    const char* statusName(BatchJobResult::Status status) {
+      switch (status) {
+        case BatchJobResult::Status::Converted: return "converted";
+        case BatchJobResult::Status::Skipped: return "skipped";
+        default: return "failed";
+      }
+    }
+  }// namespace
+
+  uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+      hash ^= data[i];
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  std::vector<BatchJob> jobsFromDirectory(
+    const std::string& inputDirectory, const std::string& outputDirectory, const ConversionOptions& options
+  ) {
+    std::vector<BatchJob> jobs;
+
+    for (const auto& entry : fs::recursive_directory_iterator(inputDirectory)) {
+      if (!entry.is_regular_file() || !isSupportedImage(entry.path())) { continue; }
+
+      auto outputFile = fs::path(outputDirectory) / fs::relative(entry.path(), inputDirectory);
+      outputFile.replace_extension(".tex");
+
+      jobs.push_back({entry.path().string(), outputFile.string(), options});
+    }
+
+    // Directory iteration order is unspecified
+    std::sort(jobs.begin(), jobs.end(), [](const auto& a, const auto& b) { return a.inputFile < b.inputFile; });
+
+    return jobs;
+  }
+
+  std::vector<BatchJob> jobsFromManifest(const std::string& manifestFile, const ConversionOptions& options) {
+    std::ifstream manifest(manifestFile);
+    if (!manifest) { throw std::runtime_error("Could not open " + manifestFile); }
+
+    auto baseDirectory = fs::path(manifestFile).parent_path();
+    std::vector<BatchJob> jobs;
+    std::string line;
+
+    for (int lineNumber = 1; std::getline(manifest, line); lineNumber++) {
+      if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+      if (line.empty() || line.front() == '#') { continue; }
+
+      auto separator = line.find('\t');
+      if (separator == std::string::npos) {
+        throw std::runtime_error(manifestFile + ":" + std::to_string(lineNumber) + ": expected input<TAB>output");
+      }
+
+      jobs.push_back({
+        (baseDirectory / line.substr(0, separator)).string(), (baseDirectory / line.substr(separator + 1)).string(),
+        options
+      });
+    }
+
+    return jobs;
+  }
+
+  std::vector<BatchJobResult> convertBatch(
+    const std::vector<BatchJob>& jobs, ThreadPool& threadPool, const std::string& cacheFile, size_t maxCachedBytes
+  ) {
+    std::vector<BatchJobResult> results(jobs.size());
+    std::vector<CacheEntry> cacheEntries(jobs.size());
+
+    std::map<std::string, CacheEntry> cache;
+    if (!cacheFile.empty()) { cache = loadCache(cacheFile); }
+
+    // Biggest inputs first, so a large file picked up last doesn't leave every other worker idle while it finishes
+    std::vector<size_t> order(jobs.size());
+    std::vector<uintmax_t> inputSizes(jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+      std::error_code error;
+      auto size = fs::file_size(jobs[i].inputFile, error);
+      order[i] = i, inputSizes[i] = error ? 0 : size;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return inputSizes[a] > inputSizes[b]; });
+
+    // Shared by every job, so the scratch buffers of one conversion are reused by the next
+    Image::BufferPool bufferPool(maxCachedBytes);
+
+    threadPool.parallelFor(jobs.size(), [&](size_t i) {
+      auto index = order[i];
+      auto& result = results[index];
+      result.job = jobs[index];
+
+      try {
+        runJob(
+          jobs[index], result, threadPool, bufferPool, maxCachedBytes == 0, cacheFile.empty() ? nullptr : &cache,
+          cacheEntries[index]
+        );
+      } catch (const std::exception& e) {
+        result.status = BatchJobResult::Status::Failed;
+        result.error = e.what();
+      }
+    });
+
+    bufferPool.clear();
+
+    if (!cacheFile.empty()) {
+      for (size_t i = 0; i < jobs.size(); i++) {
+        // Skipped entries too, so an input whose time changed but not its contents isn't hashed again
+        if (results[i].status != BatchJobResult::Status::Failed) {
+          cache[jobs[i].outputFile] = cacheEntries[i];
+        } else {
+          cache.erase(jobs[i].outputFile);
+        }
+      }
+
+      saveCache(cacheFile, cache);
+    }
+
+    return results;
+  }
+
+  void printBatchReport(const std::vector<BatchJobResult>& results, std::ostream& out) {
+    std::vector<const BatchJobResult*> sorted;
+    for (const auto& result : results) { sorted.push_back(&result); }
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a->totalTime() > b->totalTime(); });
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1);
+    report << std::setw(10) << "total ms" << std::setw(10) << "hash" << std::setw(10) << "decode" << std::setw(10)
+           << "convert" << "  " << std::left << std::setw(10) << "status" << std::right << "input\n";
+
+    size_t counts[3] = {};
+    double totals[3] = {};
+    ConversionStats stageTotals;
+
+    for (const auto* result : sorted) {
+      report << std::setw(10) << result->totalTime() << std::setw(10) << result->hashTime << std::setw(10)
+             << result->decodeTime << std::setw(10) << result->convertTime << "  " << std::left << std::setw(10)
+             << statusName(result->status) << std::right << result->job.inputFile;
+      if (!result->error.empty()) { report << ": " << result->error; }
+      report << "\n";
+
+      counts[int(result->status)]++;
+      totals[0] += result->hashTime, totals[1] += result->decodeTime, totals[2] += result->convertTime;
+      for (size_t stage = 0; stage < stageTotals.stages.size(); stage++) {
+        stageTotals.stages[stage].count += result->stats.stages[stage].count;
+        stageTotals.stages[stage].milliseconds += result->stats.stages[stage].milliseconds;
+        stageTotals.stages[stage].bytes += result->stats.stages[stage].bytes;
+      }
+    }
+
+    report << counts[0] << " converted, " << counts[1] << " skipped, " << counts[2] << " failed. Summed over jobs: "
+           << totals[0] << " ms hashing, " << totals[1] << " ms decoding, " << totals[2] << " ms converting\n";
+
+    for (size_t stage = 0; stage < stageTotals.stages.size(); stage++) {
+      const auto& stageTotal = stageTotals.stages[stage];
+      if (stageTotal.count == 0) { continue; }
+
+      report << "  " << std::left << std::setw(14) << ConversionStats::stageName(ConversionStats::Stage(stage))
+             << std::right << std::setw(10) << stageTotal.milliseconds << " ms " << std::setw(10)
+             << stageTotal.bytes / (1024.0 * 1024.0) << " MiB\n";
+    }
+
+    out << report.str();
+  }
+}// namespace TexConverter
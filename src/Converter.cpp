@@ -1,40 +1,198 @@
 #include "TexConverter/Converter.hpp"
 
-#include <BinaryTools/BinaryReader.h>
 #include <KleiLib/Mipmap.h>
+#include <KleiLib/TexFileReader.h>
+#include <KleiLib/TexFileWriter.h>
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <optional>
 
 namespace TexConverter
 {
   using Mipmap = KleiLib::Mipmap;
 
+  namespace
+  {
+    using Clock = std::chrono::steady_clock;
+    using Stage = ConversionStats::Stage;
+
+    double millisecondsSince(Clock::time_point start) {
+      return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Records into optional stats. Stages of different levels finish on different threads, so events go
+    // through a mutex.
+    class StageRecorder {
+    public:
+      explicit StageRecorder(ConversionStats* stats) : stats(stats) {}
+
+      void record(Stage stage, int level, Clock::time_point start, uint64_t bytes) {
+        if (stats == nullptr) { return; }
+
+        double milliseconds = millisecondsSince(start);
+        std::lock_guard lock(mutex);
+        stats->record({stage, level, milliseconds, bytes});
+      }
+
+    private:
+      ConversionStats* stats;
+      std::mutex mutex;
+    };
+  }// namespace
+
   void convertImageToTex(
-    Image::Image8 image,
+    const Image::ImageView8& inputImage,
     const std::string& outputFile,
     PixelFormat pixelFormat,
     MipmapFilter interpolationMode,
     TextureType textureType,
     bool generateMipmaps,
-    bool preMultiplyAlpha
+    bool preMultiplyAlpha,
+    ThreadPool* threadPool,
+    Image::Allocator* allocator,
+    ConversionStats* stats,
+    CompressionQuality quality
   ) {
-    image.flip(Image::FlipType::Vertical);
+    auto conversionStart = Clock::now();
+    StageRecorder recorder(stats);
+
+    // .tex files store their rows bottom-up. Reading the input through a flipped view saves flipping a copy of it.
+    auto image = inputImage.flippedVertical();
+
+    // Every level allocates a few scratch images of decreasing size, a pool recycles their buffers. It never needs
+    // to hold more than the RGBA mip chain of the image.
+    std::optional<Image::BufferPool> scratchPool;
+    if (allocator == nullptr) { allocator = &scratchPool.emplace(size_t(image.width) * image.height * 4 * 4 / 3); }
 
-    std::vector<Mipmap> mipmaps = {{image, pixelFormat, preMultiplyAlpha}};
+    std::vector<std::pair<int, int>> mipSizes = {{image.width, image.height}};
 
     if (generateMipmaps) {
-      auto width = image.width();
-      auto height = image.height();
+      auto width = image.width;
+      auto height = image.height;
 
       while (std::max(width, height) > 1) {
         width = std::max(1, width >> 1);
         height = std::max(1, height >> 1);
 
-        mipmaps.emplace_back(image, pixelFormat, width, height, interpolationMode, preMultiplyAlpha);
+        mipSizes.emplace_back(width, height);
       }
     }
 
+    // Written next to the output and moved in place once complete, so a failed conversion can't leave a
+    // truncated .tex behind
     using TexFile = KleiLib::TexFile;
-    TexFile outputTexFile(TexFile::Platform::Unknown, pixelFormat, textureType, 0, mipmaps);
-    outputTexFile.writeToFile(outputFile);
+    auto tempFile = outputFile + ".tmp";
+    std::optional<KleiLib::TexFileWriter> writer;
+
+    // Levels go to disk in order. The thread that hands in a level while nobody is writing becomes the writer and
+    // drains every level that's ready, writing outside the lock so the others can keep handing in theirs.
+    // Each level is freed once written.
+    std::vector<std::optional<Mipmap>> compressed(mipSizes.size());
+    size_t nextLevel = 0;
+    bool writing = false;
+    std::mutex writeMutex;
+
+    auto queueWrite = [&](size_t level, Mipmap mipmap) {
+      std::unique_lock lock(writeMutex);
+      compressed[level] = std::move(mipmap);
+      if (writing) { return; }
+
+      writing = true;
+      for (; nextLevel < compressed.size() && compressed[nextLevel]; nextLevel++) {
+        auto mip = std::move(*compressed[nextLevel]);
+        compressed[nextLevel].reset();
+        lock.unlock();
+
+        auto writeStart = Clock::now();
+        writer->write(mip);
+        recorder.record(Stage::WriteTex, int(nextLevel), writeStart, mip.data.size());
+
+        lock.lock();
+      }
+      writing = false;
+    };
+
+    auto buildMipmap = [&](size_t level, const Image::ImageView8& source) {
+      auto compressStart = Clock::now();
+      Mipmap mipmap(source, pixelFormat, preMultiplyAlpha, quality, threadPool, allocator);
+      recorder.record(Stage::Compress, int(level), compressStart, mipmap.data.size());
+
+      queueWrite(level, std::move(mipmap));
+    };
+
+    try {
+      auto start = Clock::now();
+      writer.emplace(tempFile, TexFile::Platform::Unknown, pixelFormat, textureType, 0, mipSizes);
+      recorder.record(Stage::WriteTex, -1, start, 8 + TexFile::MipHeaderSize * mipSizes.size());
+
+      if (Image::isReductionFilter(interpolationMode)) {
+        // Reduction filters derive each level from the previous one. A level is halved while it's being compressed,
+        // and dropped as soon as both are done, so only two consecutive levels are alive at a time.
+        std::optional<Image::Image8> current;
+
+        for (size_t level = 0; level < mipSizes.size(); level++) {
+          auto source = current ? current->view() : image;
+          std::optional<Image::Image8> next;
+
+          auto step = [&](size_t task) {
+            if (task == 0) {
+              buildMipmap(level, source);
+              return;
+            }
+
+            auto reduceStart = Clock::now();
+            next.emplace(Image::Image8::reduce(source, interpolationMode, allocator));
+            recorder.record(Stage::Resize, int(level + 1), reduceStart, next->view().stride * next->height());
+          };
+
+          size_t tasks = level + 1 < mipSizes.size() ? 2 : 1;
+          if (threadPool) {
+            threadPool->parallelFor(tasks, step);
+          } else {
+            for (size_t task = 0; task < tasks; task++) { step(task); }
+          }
+
+          current = std::move(next);
+        }
+      } else {
+        // Other filters resize every level straight from the full size image, so levels are independent
+        auto resizeAndBuild = [&](size_t level) {
+          if (level == 0) {
+            buildMipmap(level, image);
+            return;
+          }
+
+          auto [width, height] = mipSizes[level];
+          auto resizeStart = Clock::now();
+          auto resized = Image::Image8::resize(
+            image, width, height, interpolationMode, Image::ResampleBackend::Separable, allocator
+          );
+          recorder.record(Stage::Resize, int(level), resizeStart, resized.view().stride * height);
+
+          buildMipmap(level, resized);
+        };
+
+        if (threadPool) {
+          threadPool->parallelFor(mipSizes.size(), resizeAndBuild);
+        } else {
+          for (size_t level = 0; level < mipSizes.size(); level++) { resizeAndBuild(level); }
+        }
+      }
+
+      writer->finish();
+      writer.reset();
+    } catch (...) {
+      writer.reset();
+      std::error_code ignored;
+      std::filesystem::remove(tempFile, ignored);
+      throw;
+    }
+
+    std::filesystem::rename(tempFile, outputFile);
+
+    if (stats) { stats->totalMilliseconds = millisecondsSince(conversionStart); }
   }
 
   void convertImageToTex(
@@ -44,43 +202,56 @@ namespace TexConverter
     MipmapFilter interpolationMode,
     TextureType textureType,
     bool generateMipmaps,
-    bool preMultiplyAlpha
+    bool preMultiplyAlpha,
+    ThreadPool* threadPool,
+    Image::Allocator* allocator,
+    ConversionStats* stats,
+    CompressionQuality quality
   ) {
-    return convertImageToTex(
-      Image::Image8{inputFile},
+    auto start = Clock::now();
+    Image::Image8 image{inputFile};
+    StageRecorder(stats).record(Stage::DecodeImage, -1, start, image.view().stride * image.height());
+
+    convertImageToTex(
+      image,
       outputFile,
       pixelFormat,
       interpolationMode,
       textureType,
       generateMipmaps,
-      preMultiplyAlpha
+      preMultiplyAlpha,
+      threadPool,
+      allocator,
+      stats,
+      quality
     );
-  }
-
-  Image::Image8 convertTexToImage(const std::string& inputFile) {
-    KleiLib::TexFile tex(inputFile);
 
-    auto mipmap = tex.decompress();
-    BinaryReader imgReader(mipmap.data);
+    if (stats) { stats->totalMilliseconds = millisecondsSince(start); }
+  }
 
-    Image::Image8 image((int)mipmap.width, (int)mipmap.height, KleiLib::TexFile::TexChannels);
+  Image::Image8 convertTexToImage(const std::string& inputFile, ConversionStats* stats) {
+    StageRecorder recorder(stats);
 
-    for (int y = 0; y < mipmap.height; y++) {
-      for (int x = 0; x < mipmap.width; x++) {
-        uint8_t r = imgReader.ReadUint8();
-        uint8_t g = imgReader.ReadUint8();
-        uint8_t b = imgReader.ReadUint8();
-        uint8_t a = imgReader.ReadUint8();
-        image.setPixel(x, y, Image::Image8::PixelV4(r, g, b, a));
-      }
-    }
+    auto start = Clock::now();
+    KleiLib::TexFileReader tex(inputFile);
+    recorder.record(Stage::ReadTex, -1, start, std::filesystem::file_size(inputFile));
 
-    image.flip(Image::FlipType::Vertical);
+    auto decodeStart = Clock::now();
+    auto image = tex.decompressToImage(0, true);
+    recorder.record(Stage::DecodeTex, 0, decodeStart, image.view().stride * image.height());
 
+    if (stats) { stats->totalMilliseconds = millisecondsSince(start); }
     return image;
   }
 
-  void convertTexToImage(const std::string& inputFile, const std::string& outputFile) {
-    convertTexToImage(inputFile).write(outputFile);
+  void convertTexToImage(const std::string& inputFile, const std::string& outputFile, ConversionStats* stats) {
+    auto start = Clock::now();
+    auto image = convertTexToImage(inputFile, stats);
+
+    auto writeStart = Clock::now();
+    image.write(outputFile);
+    StageRecorder(stats).record(Stage::WriteImage, -1, writeStart, image.view().stride * image.height());
+
+    if (stats) { stats->totalMilliseconds = millisecondsSince(start); }
   }
 }// namespace TexConverter
\ No newline at end of file
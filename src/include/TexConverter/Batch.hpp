@@ -0,0 +1,81 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+
+#ifndef TEXCONVERTER_BATCH_HPP
+#define TEXCONVERTER_BATCH_HPP
+
+#include "TexConverter/Converter.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace TexConverter
+{
+  struct ConversionOptions {
+    PixelFormat pixelFormat = PixelFormat::DXT5;
+    MipmapFilter interpolationMode = MipmapFilter::Default;
+    TextureType textureType = TextureType::OneD;
+    bool generateMipmaps = false;
+    bool preMultiplyAlpha = false;
+    CompressionQuality quality = CompressionQuality::High;
+  };
+
+  struct BatchJob {
+    std::string inputFile;
+    std::string outputFile;
+    ConversionOptions options;
+  };
+
+  struct BatchJobResult {
+    enum class Status { Converted, Skipped, Failed };
+
+    BatchJob job;
+    Status status = Status::Failed;
+    std::string error;
+
+    // Milliseconds spent hashing the input, decoding it, and generating, compressing and writing the mips
+    double hashTime = 0, decodeTime = 0, convertTime = 0;
+
+    // Breakdown of the decoding and conversion
+    ConversionStats stats;
+
+    [[nodiscard]] double totalTime() const { return hashTime + decodeTime + convertTime; }
+  };
+
+  // Every image stb_image can load under inputDirectory, recursively. Outputs mirror the tree under
+  // outputDirectory, with a .tex extension.
+  std::vector<BatchJob> jobsFromDirectory(
+    const std::string& inputDirectory, const std::string& outputDirectory, const ConversionOptions& options = {}
+  );
+
+  // A manifest lists one job per line, as the input and output paths separated by a tab. Paths are relative to the
+  // manifest's directory. Empty lines and lines starting with # are ignored.
+  std::vector<BatchJob> jobsFromManifest(const std::string& manifestFile, const ConversionOptions& options = {});
+
+  // Converts every job on the thread pool. Jobs run as pool tasks and the mip levels and compression bands of each
+  // job are nested in them, so idle workers steal those from busy ones once there are no jobs left to start.
+  //
+  // When a cache file is given, a job is skipped if its output exists and its options match the ones stored for that
+  // output by a previous run, as well as either the size and modification time of its input or, when those changed,
+  // the hash of its contents. The cache file is rewritten at the end.
+  // Failed jobs don't stop the batch, they are reported in their result.
+  //
+  // Scratch buffers are recycled between jobs through a pool that keeps at most maxCachedBytes of idle buffers.
+  // 0 sizes it to the RGBA mip chain of the largest image converted so far. The pool is emptied before returning.
+  std::vector<BatchJobResult> convertBatch(
+    const std::vector<BatchJob>& jobs, ThreadPool& threadPool, const std::string& cacheFile = "",
+    size_t maxCachedBytes = 0
+  );
+
+  // Per job timings, slowest first, followed by totals and the time of each conversion stage
+  void printBatchReport(const std::vector<BatchJobResult>& results, std::ostream& out);
+
+  // 64-bit FNV-1a
+  uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+}// namespace TexConverter
+
+#endif// TEXCONVERTER_BATCH_HPP
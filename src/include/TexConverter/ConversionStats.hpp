@@ -0,0 +1,72 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+
+#ifndef TEXCONVERTER_CONVERSIONSTATS_HPP
+#define TEXCONVERTER_CONVERSIONSTATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+
+namespace TexConverter
+{
+  // Where the time of a conversion goes. Stages running on several threads at once add up their times,
+  // so the sum of the stages can be more than the wall time of the conversion.
+  struct ConversionStats {
+    enum class Stage : uint8_t {
+      DecodeImage,// input image file to pixels, bytes of the pixels
+      Resize,     // mip level generation, bytes of the level's pixels
+      Compress,   // pixels to the .tex pixel format, bytes of the compressed level
+      WriteTex,   // .tex header, mip table and levels to disk, bytes written
+      ReadTex,    // mapping and indexing a .tex file, bytes of the file
+      DecodeTex,  // .tex level to pixels, bytes of the pixels
+      WriteImage, // pixels to an image file, bytes of the pixels
+      Count
+    };
+
+    struct Event {
+      Stage stage;
+      // Mip level the event is about, -1 for stages covering the whole file
+      int level;
+      double milliseconds;
+      uint64_t bytes;
+    };
+
+    struct StageTotals {
+      size_t count = 0;
+      double milliseconds = 0;
+      uint64_t bytes = 0;
+    };
+
+    std::array<StageTotals, size_t(Stage::Count)> stages{};
+
+    // Wall time of the whole conversion
+    double totalMilliseconds = 0;
+
+    // Called for every event as it happens, never from two threads at once
+    std::function<void(const Event&)> onEvent;
+
+    [[nodiscard]] const StageTotals& operator[](Stage stage) const { return stages[size_t(stage)]; }
+
+    void record(const Event& event) {
+      auto& totals = stages[size_t(event.stage)];
+      totals.count++;
+      totals.milliseconds += event.milliseconds;
+      totals.bytes += event.bytes;
+
+      if (onEvent) { onEvent(event); }
+    }
+
+    static const char* stageName(Stage stage) {
+      constexpr const char* names[] = {
+        "decode image", "resize", "compress", "write tex", "read tex", "decode tex", "write image"
+      };
+      return stage < Stage::Count ? names[size_t(stage)] : "unknown";
+    }
+  };
+}// namespace TexConverter
+
+#endif// TEXCONVERTER_CONVERSIONSTATS_HPP
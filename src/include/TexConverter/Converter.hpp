@@ -6,7 +6,9 @@
 #define TEXCONVERTER_CONVERTER_HPP
 
 #include "Image/Image.hpp"
+#include "TexConverter/ConversionStats.hpp"
 #include <KleiLib/TexFile.h>
+#include <KleiLib/ThreadPool.h>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -15,24 +17,38 @@
 namespace TexConverter
 {
   using PixelFormat = KleiLib::Mipmap::PixelFormat;
+  using CompressionQuality = KleiLib::Mipmap::Quality;
   using TextureType = KleiLib::TexFile::TextureType;
   using MipmapFilter = Image::InterpolationMode;
+  using ThreadPool = KleiLib::ThreadPool;
+
+  // Passing a thread pool builds the mip levels in parallel and splits the block compression of each level
+  // into bands of 4x4 block rows. The resulting .tex is byte-identical to the single threaded one.
+  // Scratch images come from the given allocator, or from a buffer pool that lives for the conversion.
+  // The input image is only read, an Image8 converts to a view of itself.
+  // The compression quality picks the DXT encoder, see KleiLib::Mipmap::Quality. It has no effect on ARGB.
+  // When stats are given, the time and bytes of every stage are recorded into them.
+  // The .tex is written to outputFile + ".tmp" and only renamed to outputFile once complete.
 
   void convertImageToTex(
-    Image::Image8 image, const std::string& outputFile, PixelFormat pixelFormat = PixelFormat::DXT5,
+    const Image::ImageView8& image, const std::string& outputFile, PixelFormat pixelFormat = PixelFormat::DXT5,
     MipmapFilter interpolationMode = MipmapFilter::Default, TextureType textureType = TextureType::OneD,
-    bool generateMipmaps = false, bool preMultiplyAlpha = false
+    bool generateMipmaps = false, bool preMultiplyAlpha = false, ThreadPool* threadPool = nullptr,
+    Image::Allocator* allocator = nullptr, ConversionStats* stats = nullptr,
+    CompressionQuality quality = CompressionQuality::High
   );
 
   void convertImageToTex(
     const std::string& inputFile, const std::string& outputFile, PixelFormat pixelFormat = PixelFormat::DXT5,
     MipmapFilter interpolationMode = MipmapFilter::Default, TextureType textureType = TextureType::OneD,
-    bool generateMipmaps = false, bool preMultiplyAlpha = false
+    bool generateMipmaps = false, bool preMultiplyAlpha = false, ThreadPool* threadPool = nullptr,
+    Image::Allocator* allocator = nullptr, ConversionStats* stats = nullptr,
+    CompressionQuality quality = CompressionQuality::High
   );
 
-  Image::Image8 convertTexToImage(const std::string& inputFile);
+  Image::Image8 convertTexToImage(const std::string& inputFile, ConversionStats* stats = nullptr);
 
-  void convertTexToImage(const std::string& inputFile, const std::string& outputFile);
+  void convertTexToImage(const std::string& inputFile, const std::string& outputFile, ConversionStats* stats = nullptr);
 
 }// namespace TexConverter
 
@@ -0,0 +1,349 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <KleiLib/BlockCodec.h>
+#include <KleiLib/Mipmap.h>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using KleiLib::Mipmap;
+  using PixelFormat = Mipmap::PixelFormat;
+  using Fit = KleiLib::BlockCodec::Fit;
+
+  const PixelFormat pixelFormats[] = {PixelFormat::DXT1, PixelFormat::DXT3, PixelFormat::DXT5};
+  const Fit fits[] = {Fit::BoundingBox, Fit::PrincipalAxis};
+
+  int checked = 0, failed = 0;
+
+  void check(bool passed, const std::string& what) {
+    checked++;
+    if (passed) { return; }
+
+    // Only the first failures, a broken codec fails thousands of blocks
+    if (++failed <= 20) { std::cout << "Failed: " << what << "\n"; }
+  }
+
+  uint32_t nextRandom() {
+    static uint32_t state = 0x9e3779b9;
+    state ^= state << 13, state ^= state >> 17, state ^= state << 5;
+    return state;
+  }
+
+  int squishFlags(PixelFormat pixelFormat) {
+    return pixelFormat == PixelFormat::DXT1 ? squish::kDxt1 : pixelFormat == PixelFormat::DXT3 ? squish::kDxt3
+                                                                                               : squish::kDxt5;
+  }
+
+  size_t blockSize(PixelFormat pixelFormat) { return pixelFormat == PixelFormat::DXT1 ? 8 : 16; }
+
+  std::string name(PixelFormat pixelFormat) {
+    return pixelFormat == PixelFormat::DXT1 ? "DXT1" : pixelFormat == PixelFormat::DXT3 ? "DXT3" : "DXT5";
+  }
+
+  std::string name(Fit fit) { return fit == Fit::BoundingBox ? "bounding box" : "principal axis"; }
+
+  using Block = std::array<uint8_t, 16>;
+  using Pixels = std::array<uint8_t, 16 * 4>;
+
+  Block colourBlock(uint16_t c0, uint16_t c1, uint32_t indices) {
+    return {uint8_t(c0), uint8_t(c0 >> 8), uint8_t(c1), uint8_t(c1 >> 8), uint8_t(indices), uint8_t(indices >> 8),
+            uint8_t(indices >> 16), uint8_t(indices >> 24)};
+  }
+
+  Pixels decode(const Block& block, PixelFormat pixelFormat) {
+    Pixels rgba;
+    KleiLib::BlockCodec::decodeBlock(block.data(), rgba.data(), pixelFormat);
+    return rgba;
+  }
+
+  Pixels encodeAndDecode(const Pixels& rgba, PixelFormat pixelFormat, Fit fit) {
+    Block block;
+    KleiLib::BlockCodec::encodeBlock(rgba.data(), block.data(), pixelFormat, fit);
+    return decode(block, pixelFormat);
+  }
+
+  // Largest difference of a channel between two sets of pixels, only counting the pixels picked by include
+  template<typename Include>
+  int maxError(const Pixels& a, const Pixels& b, int channel, Include include) {
+    int error = 0;
+    for (int i = 0; i < 16; i++) {
+      if (include(i)) { error = std::max(error, std::abs(a[i * 4 + channel] - b[i * 4 + channel])); }
+    }
+    return error;
+  }
+
+  int maxError(const Pixels& a, const Pixels& b, int channel) {
+    return maxError(a, b, channel, [](int) { return true; });
+  }
+
+  // decodeBlock has to give exactly what squish::Decompress gives, including the DXT1 3 colour mode,
+  // the DXT5 6 value mode and the colour blocks of DXT3 and DXT5 that ignore the endpoint order
+  void testDecoder() {
+    const std::pair<uint16_t, uint16_t> endpoints[] = {
+      {0x0000, 0x0000}, {0xffff, 0xffff}, {0xffff, 0x0000}, {0x0000, 0xffff}, {0xf800, 0x001f},
+      {0x001f, 0xf800}, {0x7bef, 0x7bef}, {0x1235, 0x1234}, {0x1234, 0x1235}, {0x07e0, 0x07e0},
+    };
+    const uint32_t colourIndices[] = {0x00000000, 0x55555555, 0xaaaaaaaa, 0xffffffff, 0xe4e4e4e4, 0x1b1b1b1b};
+    const std::pair<uint8_t, uint8_t> alphaEndpoints[] = {
+      {255, 0}, {0, 255}, {128, 128}, {0, 0}, {255, 255}, {200, 10}, {10, 200}, {1, 0}, {0, 1},
+    };
+    // Every one of the 8 codes twice
+    const uint64_t alphaIndices = 0xfac688fac688;
+
+    std::vector<Block> blocks;
+    for (auto [c0, c1] : endpoints) {
+      for (auto indices : colourIndices) {
+        auto colour = colourBlock(c0, c1, indices);
+
+        for (auto [a0, a1] : alphaEndpoints) {
+          Block block{a0, a1};
+          for (int i = 0; i < 6; i++) { block[2 + i] = uint8_t(alphaIndices >> (8 * i)); }
+          std::copy_n(colour.begin(), 8, block.begin() + 8);
+          blocks.push_back(block);
+        }
+
+        // DXT1 only reads the first 8 bytes, the alpha of DXT3 gets every 4 bit value
+        Block block{};
+        std::copy_n(colour.begin(), 8, block.begin());
+        for (int i = 0; i < 8; i++) { block[8 + i] = uint8_t(0x10 * (2 * i) | (2 * i + 1)); }
+        blocks.push_back(block);
+      }
+    }
+    for (int i = 0; i < 20000; i++) {
+      Block block;
+      for (auto& byte : block) { byte = uint8_t(nextRandom()); }
+      blocks.push_back(block);
+    }
+
+    for (auto pixelFormat : pixelFormats) {
+      int mismatches = 0;
+      for (const auto& block : blocks) {
+        // DXT1 blocks are decoded from both halves of the test blocks
+        for (size_t offset = 0; offset < (pixelFormat == PixelFormat::DXT1 ? 16 : 1); offset += 8) {
+          Pixels expected, actual;
+          squish::Decompress(expected.data(), block.data() + offset, squishFlags(pixelFormat));
+          KleiLib::BlockCodec::decodeBlock(block.data() + offset, actual.data(), pixelFormat);
+          mismatches += expected != actual;
+        }
+      }
+      check(mismatches == 0, name(pixelFormat) + " blocks decode like squish::Decompress, " +
+                               std::to_string(mismatches) + " differ");
+    }
+
+    // Whole images, with partial blocks on the right and bottom edges
+    const int width = 13, height = 7;
+    for (auto pixelFormat : pixelFormats) {
+      std::vector<uint8_t> data(Mipmap::storageSize(width, height, pixelFormat));
+      for (auto& byte : data) { byte = uint8_t(nextRandom()); }
+
+      std::vector<uint8_t> expected(size_t(width) * height * 4);
+      squish::DecompressImage(expected.data(), width, height, data.data(), squishFlags(pixelFormat));
+      check(Mipmap::decompress(data, width, height, pixelFormat) == expected,
+            name(pixelFormat) + " images decode like squish::DecompressImage");
+    }
+  }
+
+  // Expanded 5 or 6 bit value of a channel, what a decoder can give back exactly
+  uint8_t expand(int value, int bits) { return uint8_t(value << (8 - bits) | value >> (2 * bits - 8)); }
+
+  // Quality bounds the Fast and Normal encoders have to keep
+  void testEncoderErrorBounds() {
+    for (auto pixelFormat : pixelFormats) {
+      for (auto fit : fits) {
+        auto label = name(pixelFormat) + " " + name(fit) + ": ";
+
+        // A single colour only loses the 5:6:5 quantization, and the alpha its own
+        int worstColour[3] = {}, worstAlpha = 0;
+        for (int test = 0; test < 2000; test++) {
+          Pixels rgba;
+          uint32_t colour = nextRandom();
+          for (int i = 0; i < 16; i++) {
+            for (int ch = 0; ch < 4; ch++) { rgba[i * 4 + ch] = uint8_t(colour >> (8 * ch)); }
+            if (pixelFormat == PixelFormat::DXT1) { rgba[i * 4 + 3] = 255; }
+          }
+
+          auto decoded = encodeAndDecode(rgba, pixelFormat, fit);
+          for (int ch = 0; ch < 3; ch++) { worstColour[ch] = std::max(worstColour[ch], maxError(rgba, decoded, ch)); }
+          worstAlpha = std::max(worstAlpha, maxError(rgba, decoded, 3));
+        }
+        check(worstColour[0] <= 4 && worstColour[1] <= 2 && worstColour[2] <= 4,
+              label + "single colour blocks are within the 5:6:5 rounding");
+        check(worstAlpha <= (pixelFormat == PixelFormat::DXT3 ? 8 : 0),
+              label + "single alpha blocks are within the alpha rounding");
+
+        // Two colours the format can store are stored exactly by the principal axis fit
+        if (fit == Fit::PrincipalAxis) {
+          int worst = 0;
+          for (int test = 0; test < 2000; test++) {
+            uint8_t colours[2][3];
+            for (auto& colour : colours) {
+              colour[0] = expand(int(nextRandom() % 32), 5);
+              colour[1] = expand(int(nextRandom() % 64), 6);
+              colour[2] = expand(int(nextRandom() % 32), 5);
+            }
+
+            Pixels rgba;
+            uint32_t pick = nextRandom();
+            for (int i = 0; i < 16; i++) {
+              std::copy_n(colours[(pick >> i) & 1], 3, &rgba[i * 4]);
+              rgba[i * 4 + 3] = 255;
+            }
+
+            auto decoded = encodeAndDecode(rgba, pixelFormat, fit);
+            for (int ch = 0; ch < 3; ch++) { worst = std::max(worst, maxError(rgba, decoded, ch)); }
+          }
+          check(worst == 0, label + "blocks of two 5:6:5 colours are lossless, off by " + std::to_string(worst));
+        }
+
+        // Gradients are at most half a palette step off, plus the 5:6:5 rounding
+        int worstExcess = INT_MIN;
+        for (int test = 0; test < 2000; test++) {
+          int start[3], step[3], range = 0;
+          for (int ch = 0; ch < 3; ch++) {
+            step[ch] = int(nextRandom() % 13) - 6;
+            start[ch] = step[ch] < 0 ? 255 - int(nextRandom() % 64) : int(nextRandom() % 64);
+            range = std::max(range, std::abs(step[ch]) * 15);
+          }
+
+          Pixels rgba;
+          for (int i = 0; i < 16; i++) {
+            for (int ch = 0; ch < 3; ch++) { rgba[i * 4 + ch] = uint8_t(start[ch] + step[ch] * i); }
+            rgba[i * 4 + 3] = 255;
+          }
+
+          auto decoded = encodeAndDecode(rgba, pixelFormat, fit);
+          for (int ch = 0; ch < 3; ch++) {
+            worstExcess = std::max(worstExcess, maxError(rgba, decoded, ch) - (range / 6 + 5));
+          }
+        }
+        check(worstExcess <= 0, label + "gradients are within half a palette step, " + std::to_string(worstExcess) +
+                                  " over");
+      }
+    }
+
+    // DXT1 stores pixels under half alpha as transparent black, through the 3 colour mode
+    for (auto fit : fits) {
+      for (int test = 0; test < 500; test++) {
+        Pixels rgba;
+        uint32_t colour = nextRandom(), transparent = nextRandom() & 0xffff;
+        for (int i = 0; i < 16; i++) {
+          for (int ch = 0; ch < 3; ch++) { rgba[i * 4 + ch] = uint8_t(colour >> (8 * ch)); }
+          rgba[i * 4 + 3] = (transparent >> i) & 1 ? uint8_t(nextRandom() % 128) : uint8_t(128 + nextRandom() % 128);
+        }
+
+        Block block;
+        KleiLib::BlockCodec::encodeBlock(rgba.data(), block.data(), PixelFormat::DXT1, fit);
+        auto decoded = decode(block, PixelFormat::DXT1);
+
+        bool alphaMatches = true;
+        for (int i = 0; i < 16; i++) { alphaMatches &= decoded[i * 4 + 3] == ((transparent >> i) & 1 ? 0 : 255); }
+        bool threeColourMode = (block[0] | block[1] << 8) <= (block[2] | block[3] << 8);
+        auto opaque = [&](int i) { return !((transparent >> i) & 1); };
+
+        check(alphaMatches && (transparent == 0 || threeColourMode),
+              "DXT1 " + name(fit) + ": transparent pixels use the 3 colour mode");
+        check(maxError(rgba, decoded, 0, opaque) <= 4 && maxError(rgba, decoded, 1, opaque) <= 2 &&
+                maxError(rgba, decoded, 2, opaque) <= 4,
+              "DXT1 " + name(fit) + ": opaque pixels next to transparent ones keep their colour");
+      }
+    }
+
+    // DXT5 blocks mixing fully transparent and opaque pixels with others keep both exactly with the 6 value mode
+    for (int test = 0; test < 500; test++) {
+      Pixels rgba{};
+      int low = int(nextRandom() % 200) + 20, high = low + int(nextRandom() % 30);
+      for (int i = 0; i < 16; i++) {
+        uint32_t kind = nextRandom() % 4;
+        rgba[i * 4 + 3] = uint8_t(kind == 0 ? 0 : kind == 1 ? 255 : low + int(nextRandom() % (high - low + 1)));
+      }
+
+      Block block;
+      KleiLib::BlockCodec::encodeBlock(rgba.data(), block.data(), PixelFormat::DXT5, Fit::PrincipalAxis);
+      auto decoded = decode(block, PixelFormat::DXT5);
+
+      auto extreme = [&](int i) { return rgba[i * 4 + 3] == 0 || rgba[i * 4 + 3] == 255; };
+      auto between = [&](int i) { return !extreme(i); };
+      check(maxError(rgba, decoded, 3, extreme) == 0 && maxError(rgba, decoded, 3, between) <= (high - low) / 10 + 1,
+            "DXT5 principal axis: the 6 value mode keeps 0 and 255 exactly");
+    }
+  }
+
+  // encodeImage may encode several blocks at once, it has to give the same blocks as encodeBlock
+  void testEncodeImage() {
+    const int width = 37, height = 11;
+    std::vector<uint8_t> rgba(size_t(width) * height * 4);
+
+    for (int pattern = 0; pattern < 3; pattern++) {
+      for (size_t i = 0; i < rgba.size(); i++) {
+        auto value = uint8_t(nextRandom());
+        // Noise, then smooth colours with cutout alpha, then opaque
+        if (pattern > 0 && i % 4 != 3) { value = uint8_t(i / 4 % width * 6 + i / 4 / width * 9 + i % 4 * 40); }
+        if (pattern == 1 && i % 4 == 3) { value = value < 96 ? 0 : 255; }
+        if (pattern == 2 && i % 4 == 3) { value = 255; }
+        rgba[i] = value;
+      }
+
+      for (auto pixelFormat : pixelFormats) {
+        for (auto fit : fits) {
+          std::vector<uint8_t> blocks(Mipmap::storageSize(width, height, pixelFormat));
+          KleiLib::BlockCodec::encodeImage(rgba.data(), width, height, width * 4, blocks.data(), pixelFormat, fit);
+
+          bool matches = true;
+          const uint8_t* block = blocks.data();
+          for (int by = 0; by < height; by += 4) {
+            for (int bx = 0; bx < width; bx += 4, block += blockSize(pixelFormat)) {
+              Pixels pixels;
+              for (int i = 0; i < 16; i++) {
+                int x = std::min(bx + i % 4, width - 1), y = std::min(by + i / 4, height - 1);
+                std::copy_n(&rgba[(size_t(y) * width + x) * 4], 4, &pixels[i * 4]);
+              }
+
+              Block expected;
+              KleiLib::BlockCodec::encodeBlock(pixels.data(), expected.data(), pixelFormat, fit);
+              matches &= std::equal(block, block + blockSize(pixelFormat), expected.begin());
+            }
+          }
+          auto label = name(pixelFormat) + " " + name(fit) + ", pattern " + std::to_string(pattern);
+          check(matches, label + ": encodeImage gives the blocks of encodeBlock");
+        }
+      }
+    }
+  }
+
+  // Error of whole images against the source. The floors are a few dB under what the encoders reach today,
+  // the principal axis fit has to stay at least as good as the bounding box one.
+  void testImageError() {
+    Image::Image8 image(std::string(TEST_ASSETS_DIR) + "/wurt.png");
+    const double floors[3][2] = {{31.5, 32}, {35, 36}, {35, 36}};
+
+    for (size_t format = 0; format < 3; format++) {
+      auto pixelFormat = pixelFormats[format];
+      auto fast = Mipmap(image, pixelFormat, true, Mipmap::Quality::Fast).measureError(image, pixelFormat, true);
+      auto normal = Mipmap(image, pixelFormat, true, Mipmap::Quality::Normal).measureError(image, pixelFormat, true);
+
+      std::cout << name(pixelFormat) << " PSNR: Fast " << fast.psnr << " dB, Normal " << normal.psnr << " dB\n";
+      check(fast.psnr >= floors[format][0], name(pixelFormat) + " Fast stays above its PSNR floor");
+      check(normal.psnr >= floors[format][1], name(pixelFormat) + " Normal stays above its PSNR floor");
+      check(normal.rmse <= fast.rmse, name(pixelFormat) + " Normal is at least as good as Fast");
+    }
+  }
+}// namespace
+
+int main() {
+  testDecoder();
+  testEncoderErrorBounds();
+  testEncodeImage();
+  testImageError();
+
+  std::cout << checked - failed << " of " << checked << " block codec checks passed.\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <TexConverter/Converter.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+  std::vector<char> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+}// namespace
+
+// Converting on a thread pool has to give exactly the same .tex as the single threaded conversion, for every
+// pixel format, mipmap filter and compression quality
+int main() {
+  using TexConverter::CompressionQuality;
+  using TexConverter::MipmapFilter;
+  using TexConverter::PixelFormat;
+
+  Image::Image8 image(std::string(TEST_ASSETS_DIR) + "/wurt.png");
+  TexConverter::ThreadPool threadPool(4);
+
+  const PixelFormat pixelFormats[] = {PixelFormat::DXT1, PixelFormat::DXT3, PixelFormat::DXT5, PixelFormat::ARGB};
+  const MipmapFilter filters[] = {
+    MipmapFilter::NearestNeighbor, MipmapFilter::Bilinear, MipmapFilter::Bicubic, MipmapFilter::HighQualityBilinear,
+    MipmapFilter::HighQualityBicubic, MipmapFilter::Box, MipmapFilter::Kaiser, MipmapFilter::Lanczos
+  };
+  const CompressionQuality qualities[] = {
+    CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High
+  };
+
+  int checked = 0, failed = 0;
+  for (auto pixelFormat : pixelFormats) {
+    for (auto filter : filters) {
+      for (auto quality : qualities) {
+        // The quality has no effect on ARGB
+        if (pixelFormat == PixelFormat::ARGB && quality != CompressionQuality::High) { continue; }
+
+        for (bool preMultiplyAlpha : {false, true}) {
+          auto convert = [&](const std::string& path, TexConverter::ThreadPool* pool) {
+            TexConverter::convertImageToTex(
+              image, path, pixelFormat, filter, TexConverter::TextureType::TwoD, true, preMultiplyAlpha, pool,
+              nullptr, nullptr, quality
+            );
+            return readFile(path);
+          };
+
+          checked++;
+          if (convert("serial.tex", nullptr) != convert("parallel.tex", &threadPool)) {
+            failed++;
+            std::cout << "Mismatch: pixel format " << int(pixelFormat) << ", filter " << int(filter) << ", quality "
+                      << int(quality) << ", premultiplied alpha " << preMultiplyAlpha << "\n";
+          }
+        }
+      }
+    }
+  }
+
+  std::cout << checked - failed << " of " << checked << " parallel conversions match the serial ones.\n";
+  return failed == 0 ? 0 : 1;
+}
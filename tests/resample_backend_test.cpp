@@ -0,0 +1,118 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <Image/Image.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace
+{
+  using Mode = Image::InterpolationMode;
+  using Backend = Image::ResampleBackend;
+
+  const std::pair<Mode, const char*> modes[] = {
+    {Mode::NearestNeighbor, "nearest"}, {Mode::Bilinear, "bilinear"}, {Mode::Bicubic, "bicubic"},
+    {Mode::HighQualityBilinear, "hqbilinear"}, {Mode::HighQualityBicubic, "hqbicubic"}, {Mode::Box, "box"},
+    {Mode::Kaiser, "kaiser"}, {Mode::Lanczos, "lanczos"}
+  };
+
+  // Downscales by integer and non integer factors, the same size, and an upscale
+  const std::pair<int, int> sourceSize = {97, 61};
+  const std::pair<int, int> targetSizes[] = {{48, 30}, {40, 25}, {23, 14}, {97, 61}, {150, 90}};
+
+  int checked = 0, failed = 0;
+
+  // Smooth gradients with some noise, fully opaque
+  template<typename ChannelT>
+  Image::Image<ChannelT> generate(int channels) {
+    auto [width, height] = sourceSize;
+    Image::Image<ChannelT> image(width, height, channels);
+    const double max = double(ChannelT(-1));
+    uint32_t noise = 1;
+
+    ChannelT* pixel = image.data();
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        for (int ch = 0; ch < channels; ch++, pixel++) {
+          noise = noise * 1103515245 + 12345;
+          double value = 0.5 + 0.35 * std::sin(x * 0.21 + ch) * std::cos(y * 0.17) + (noise >> 16) % 100 / 1000.0;
+          *pixel = ch == 3 ? ChannelT(-1) : ChannelT(value * max);
+        }
+      }
+    }
+
+    return image;
+  }
+
+  // Size of the image the last resampling pass reads from. Reduction filters halve the image first, as long as
+  // the result isn't smaller than the target, both backends share that part.
+  std::pair<int, int> lastPassSource(Mode mode, int width, int height) {
+    auto [sourceWidth, sourceHeight] = sourceSize;
+    if (!Image::isReductionFilter(mode)) { return {sourceWidth, sourceHeight}; }
+
+    while ((sourceWidth >> 1) >= width && (sourceHeight >> 1) >= height) {
+      sourceWidth = std::max(1, sourceWidth >> 1), sourceHeight = std::max(1, sourceHeight >> 1);
+    }
+    return {sourceWidth, sourceHeight};
+  }
+
+  // Whether every tap of the reference for this output coordinate is inside the image. The reference samples
+  // at x * source / target, its widest kernel reads from 1 pixel before to 2 after.
+  bool awayFromBorder(int x, int target, int source) {
+    double position = double(x) * source / target;
+    return position >= 2 && position <= source - 3;
+  }
+
+  template<typename ChannelT>
+  void testBackends(const char* typeName, int tolerance) {
+    for (int channels = 1; channels <= 4; channels++) {
+      auto image = generate<ChannelT>(channels);
+
+      for (auto [mode, modeName] : modes) {
+        for (auto [width, height] : targetSizes) {
+          auto separable = image.resize(width, height, mode, Backend::Separable);
+          auto reference = image.resize(width, height, mode, Backend::Reference);
+          auto [lastWidth, lastHeight] = lastPassSource(mode, width, height);
+
+          int worst = 0;
+          for (int y = 0; y < height; y++) {
+            if (!awayFromBorder(y, height, lastHeight)) { continue; }
+
+            for (int x = 0; x < width; x++) {
+              if (!awayFromBorder(x, width, lastWidth)) { continue; }
+
+              for (int ch = 0; ch < channels; ch++) {
+                auto index = (size_t(y) * width + x) * channels + ch;
+                worst = std::max(worst, std::abs(int(separable.data()[index]) - int(reference.data()[index])));
+              }
+            }
+          }
+
+          // Nearest neighbour picks the same pixels, everything else may round differently
+          int allowed = mode == Mode::NearestNeighbor ? 0 : tolerance;
+          checked++;
+          if (worst > allowed) {
+            failed++;
+            std::cout << "Mismatch: " << typeName << ", " << channels << " channels, " << modeName << ", " << width
+                      << "x" << height << ": off by " << worst << ", at most " << allowed << " allowed\n";
+          }
+        }
+      }
+    }
+  }
+}// namespace
+
+// The separable and reference resize backends have to stay within the tolerance documented on
+// Image::ResampleBackend, for every interpolation mode, channel count and channel type
+int main() {
+  testBackends<uint8_t>("8 bit", 1);
+  testBackends<uint16_t>("16 bit", 4);
+
+  std::cout << checked - failed << " of " << checked << " resizes are within the documented tolerance.\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <TexConverter/Batch.hpp>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const char* usage =
+    "usage: tex_batch [options] <input directory> <output directory>\n"
+    "       tex_batch [options] --manifest <manifest file>\n"
+    "\n"
+    "  --format DXT1|DXT3|DXT5|ARGB      pixel format (DXT5)\n"
+    "  --filter <name>                   mipmap filter: nearest, bilinear, bicubic, hqbilinear, hqbicubic, box,\n"
+    "                                    kaiser or lanczos (bilinear)\n"
+    "  --type 1d|2d|3d|cube              texture type (1d)\n"
+    "  --quality fast|normal|high        DXT encoder: built-in bounding box or principal axis fit, or libsquish\n"
+    "                                    (high)\n"
+    "  --mips                            generate mipmaps\n"
+    "  --premultiply                     premultiply alpha\n"
+    "  --threads <n>                     worker threads, 0 for one per hardware thread (0)\n"
+    "  --buffer-cache <MiB>              idle scratch buffers kept between jobs, 0 for the mip chain of the\n"
+    "                                    largest image (0)\n"
+    "  --cache <file>                    incremental build cache (.tex_cache in the output directory, or next to\n"
+    "                                    the manifest)\n"
+    "  --no-cache                        convert every job\n"
+    "\n"
+    "Manifests list one job per line as the input and output paths separated by a tab.\n";
+
+  template<typename T>
+  T parseOption(const std::map<std::string, T>& values, const std::string& option, const std::string& value) {
+    auto it = values.find(value);
+    if (it == values.end()) { throw std::invalid_argument("invalid value for " + option + ": " + value); }
+    return it->second;
+  }
+}// namespace
+
+int main(int argc, char** argv) {
+  using namespace TexConverter;
+  namespace fs = std::filesystem;
+
+  ConversionOptions options;
+  options.interpolationMode = MipmapFilter::Default;
+  std::string manifestFile, cacheFile;
+  bool useCache = true;
+  unsigned threads = 0;
+  size_t bufferCacheBytes = 0;
+  std::vector<std::string> positional;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      auto value = [&] {
+        if (i + 1 >= argc) { throw std::invalid_argument("missing value for " + arg); }
+        return std::string(argv[++i]);
+      };
+
+      if (arg == "--format") {
+        options.pixelFormat = parseOption<PixelFormat>(
+          {{"DXT1", PixelFormat::DXT1}, {"DXT3", PixelFormat::DXT3}, {"DXT5", PixelFormat::DXT5},
+           {"ARGB", PixelFormat::ARGB}}, arg, value()
+        );
+      } else if (arg == "--filter") {
+        options.interpolationMode = parseOption<MipmapFilter>(
+          {{"nearest", MipmapFilter::NearestNeighbor}, {"bilinear", MipmapFilter::Bilinear},
+           {"bicubic", MipmapFilter::Bicubic}, {"hqbilinear", MipmapFilter::HighQualityBilinear},
+           {"hqbicubic", MipmapFilter::HighQualityBicubic}, {"box", MipmapFilter::Box},
+           {"kaiser", MipmapFilter::Kaiser}, {"lanczos", MipmapFilter::Lanczos}}, arg, value()
+        );
+      } else if (arg == "--type") {
+        options.textureType = parseOption<TextureType>(
+          {{"1d", TextureType::OneD}, {"2d", TextureType::TwoD}, {"3d", TextureType::ThreeD},
+           {"cube", TextureType::Cubemap}}, arg, value()
+        );
+      } else if (arg == "--quality") {
+        options.quality = parseOption<CompressionQuality>(
+          {{"fast", CompressionQuality::Fast}, {"normal", CompressionQuality::Normal},
+           {"high", CompressionQuality::High}}, arg, value()
+        );
+      } else if (arg == "--mips") {
+        options.generateMipmaps = true;
+      } else if (arg == "--premultiply") {
+        options.preMultiplyAlpha = true;
+      } else if (arg == "--threads") {
+        threads = std::stoul(value());
+      } else if (arg == "--buffer-cache") {
+        bufferCacheBytes = size_t(std::stoull(value())) << 20;
+      } else if (arg == "--manifest") {
+        manifestFile = value();
+      } else if (arg == "--cache") {
+        cacheFile = value();
+      } else if (arg == "--no-cache") {
+        useCache = false;
+      } else if (arg == "--help" || arg == "-h") {
+        std::cout << usage;
+        return 0;
+      } else if (arg.starts_with("--")) {
+        throw std::invalid_argument("unknown option " + arg);
+      } else {
+        positional.push_back(arg);
+      }
+    }
+
+    if (manifestFile.empty() ? positional.size() != 2 : !positional.empty()) {
+      throw std::invalid_argument("expected an input and an output directory, or a manifest");
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n\n" << usage;
+    return 2;
+  }
+
+  try {
+    std::vector<BatchJob> jobs;
+
+    if (manifestFile.empty()) {
+      jobs = jobsFromDirectory(positional[0], positional[1], options);
+      if (cacheFile.empty()) { cacheFile = (fs::path(positional[1]) / ".tex_cache").string(); }
+    } else {
+      jobs = jobsFromManifest(manifestFile, options);
+      if (cacheFile.empty()) { cacheFile = (fs::path(manifestFile).parent_path() / ".tex_cache").string(); }
+    }
+
+    if (!useCache) { cacheFile.clear(); }
+    if (!cacheFile.empty() && fs::path(cacheFile).has_parent_path()) {
+      fs::create_directories(fs::path(cacheFile).parent_path());
+    }
+
+    ThreadPool threadPool(threads);
+    std::cout << "Converting " << jobs.size() << " images on " << threadPool.size() << " threads...\n";
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = convertBatch(jobs, threadPool, cacheFile, bufferCacheBytes);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    printBatchReport(results, std::cout);
+    std::cout << "Done in " << elapsed.count() << " ms\n";
+
+    for (const auto& result : results) {
+      if (result.status == BatchJobResult::Status::Failed) { return 1; }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,251 @@
+//
+// Created by Lobato on 17/10/2026.
+//
+#include <KleiLib/Mipmap.h>
+#include <KleiLib/TexFile.h>
+#include <KleiLib/TexFileReader.h>
+#include <KleiLib/TexFileWriter.h>
+#include <TexConverter/Converter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  namespace fs = std::filesystem;
+
+  const char* usage =
+    "usage: tex_bench [options] [filter]\n"
+    "\n"
+    "  --repeat <n>      timed runs per benchmark, the median is reported (5)\n"
+    "  --quick           skip the largest corpus images\n"
+    "  --corpus <dir>    where the generated corpus is written (tex_bench_corpus)\n"
+    "\n"
+    "Only benchmarks whose name contains the filter are run.\n";
+
+  enum class AlphaPattern { Opaque, Cutout, Gradient, Noise };
+
+  struct CorpusImage {
+    std::string name;
+    int width, height, channels;
+    AlphaPattern alpha;
+  };
+
+  // Sizes, channel counts and alpha patterns the converter meets in practice. The odd sized one exercises
+  // partial blocks and uneven mip chains.
+  const std::vector<CorpusImage> corpus = {
+    {"icon_64", 64, 64, 4, AlphaPattern::Cutout},
+    {"mask_512", 512, 512, 1, AlphaPattern::Opaque},
+    {"ui_256", 256, 256, 4, AlphaPattern::Gradient},
+    {"odd_300x374", 300, 374, 4, AlphaPattern::Noise},
+    {"terrain_1024", 1024, 1024, 3, AlphaPattern::Opaque},
+    {"atlas_2048", 2048, 2048, 4, AlphaPattern::Cutout},
+  };
+
+  uint32_t hash(uint32_t x) {
+    x ^= x >> 16, x *= 0x7feb352d;
+    x ^= x >> 15, x *= 0x846ca68b;
+    return x ^ (x >> 16);
+  }
+
+  // Smooth gradients, some higher frequency detail and a bit of noise, always the same for the same image
+  Image::Image8 generate(const CorpusImage& entry) {
+    Image::Image8 image(entry.width, entry.height, entry.channels);
+    uint8_t* pixel = image.data();
+
+    for (int y = 0; y < entry.height; y++) {
+      for (int x = 0; x < entry.width; x++, pixel += entry.channels) {
+        float u = float(x) / float(entry.width), v = float(y) / float(entry.height);
+        uint32_t noise = hash(uint32_t(y * entry.width + x));
+        float detail = std::sin(u * 40.f) * std::cos(v * 30.f);
+
+        float colour[3] = {255.f * u, 255.f * v, 128.f + 100.f * detail};
+        for (int ch = 0; ch < std::min(entry.channels, 3); ch++) {
+          pixel[ch] = uint8_t(std::clamp(colour[ch] + float(noise >> (8 * ch) & 15) - 8.f, 0.f, 255.f));
+        }
+
+        if (entry.channels == 2 || entry.channels == 4) {
+          float radius = std::hypot(u - 0.5f, v - 0.5f);
+          uint8_t alpha = 255;
+
+          switch (entry.alpha) {
+            case AlphaPattern::Opaque: break;
+            case AlphaPattern::Cutout: alpha = radius < 0.35f + 0.05f * detail ? 255 : 0; break;
+            case AlphaPattern::Gradient: alpha = uint8_t(std::clamp(255.f * (1.f - 2.f * radius), 0.f, 255.f)); break;
+            case AlphaPattern::Noise: alpha = uint8_t(noise >> 24); break;
+          }
+          pixel[entry.channels - 1] = alpha;
+        }
+      }
+    }
+
+    return image;
+  }
+
+  class Bench {
+  public:
+    Bench(int repeat, std::string filter) : repeat(repeat), filter(std::move(filter)) {
+      std::cout << std::left << std::setw(28) << "benchmark" << std::setw(16) << "image" << std::right << std::setw(12)
+                << "median ms" << std::setw(12) << "min ms" << std::setw(12) << "Mpixel/s" << "\n";
+    }
+
+    // Runs fn once to warm up, then repeat times, and prints the median and fastest run.
+    // pixels is what the throughput is computed from.
+    void run(const std::string& name, const CorpusImage& image, size_t pixels, const std::function<void()>& fn) {
+      if (name.find(filter) == std::string::npos) { return; }
+
+      fn();
+
+      std::vector<double> times;
+      for (int i = 0; i < repeat; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      }
+      std::sort(times.begin(), times.end());
+
+      double median = times[times.size() / 2];
+      std::cout << std::left << std::setw(28) << name << std::setw(16) << image.name << std::right << std::fixed
+                << std::setprecision(3) << std::setw(12) << median << std::setw(12) << times.front()
+                << std::setprecision(1) << std::setw(12) << double(pixels) / median / 1000.0 << "\n";
+    }
+
+    [[nodiscard]] bool selected(const std::string& name) const { return name.find(filter) != std::string::npos; }
+
+  private:
+    int repeat;
+    std::string filter;
+  };
+}// namespace
+
+int main(int argc, char** argv) {
+  using PixelFormat = KleiLib::Mipmap::PixelFormat;
+  using Quality = KleiLib::Mipmap::Quality;
+  using Mode = Image::InterpolationMode;
+
+  int repeat = 5;
+  bool quick = false;
+  std::string corpusDirectory = "tex_bench_corpus", filter;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--quick") {
+      quick = true;
+    } else if (arg == "--corpus" && i + 1 < argc) {
+      corpusDirectory = argv[++i];
+    } else if (arg.starts_with("-")) {
+      std::cerr << usage;
+      return arg == "--help" || arg == "-h" ? 0 : 2;
+    } else {
+      filter = arg;
+    }
+  }
+
+  const std::pair<Mode, const char*> modes[] = {
+    {Mode::NearestNeighbor, "nearest"}, {Mode::Bilinear, "bilinear"}, {Mode::Bicubic, "bicubic"},
+    {Mode::HighQualityBilinear, "hqbilinear"}, {Mode::HighQualityBicubic, "hqbicubic"}, {Mode::Box, "box"},
+    {Mode::Kaiser, "kaiser"}, {Mode::Lanczos, "lanczos"}
+  };
+  const std::pair<PixelFormat, const char*> pixelFormats[] = {
+    {PixelFormat::DXT1, "dxt1"}, {PixelFormat::DXT3, "dxt3"}, {PixelFormat::DXT5, "dxt5"}, {PixelFormat::ARGB, "argb"}
+  };
+  const std::pair<Quality, const char*> qualities[] = {
+    {Quality::Fast, "fast"}, {Quality::Normal, "normal"}, {Quality::High, "high"}
+  };
+
+  fs::create_directories(corpusDirectory);
+  Bench bench(repeat, filter);
+
+  for (const auto& entry : corpus) {
+    if (quick && size_t(entry.width) * entry.height > 1024 * 1024) { continue; }
+
+    auto pngPath = (fs::path(corpusDirectory) / (entry.name + ".png")).string();
+    auto texPath = (fs::path(corpusDirectory) / (entry.name + ".tex")).string();
+    auto pixels = size_t(entry.width) * entry.height;
+
+    generate(entry).write(pngPath);
+    Image::Image8 image(pngPath);
+
+    bench.run("load/stb", entry, pixels, [&] { Image::Image8 loaded(pngPath); });
+
+    for (auto [mode, modeName] : modes) {
+      bench.run(std::string("resize/") + modeName, entry, pixels, [&] {
+        auto resized = image.resize(std::max(1, entry.width / 2), std::max(1, entry.height / 2), mode);
+      });
+    }
+
+    bench.run("prefilter/gaussian", entry, pixels, [&] { auto blurred = Image::Image8::prefilterGaussian(image); });
+
+    for (auto [pixelFormat, formatName] : pixelFormats) {
+      for (auto [quality, qualityName] : qualities) {
+        // The quality only picks the DXT encoder
+        if (pixelFormat == PixelFormat::ARGB && quality != Quality::High) { continue; }
+
+        auto name = std::string("compress/") + formatName + (pixelFormat == PixelFormat::ARGB ? "" : "/") +
+                    (pixelFormat == PixelFormat::ARGB ? "" : qualityName);
+        bench.run(name, entry, pixels, [&] { KleiLib::Mipmap mip(image, pixelFormat, false, quality); });
+      }
+    }
+
+    // A full mip chain, for the file benchmarks
+    std::vector<KleiLib::Mipmap> mips;
+    std::vector<std::pair<int, int>> mipSizes;
+    Image::Image8 level = image;
+    while (true) {
+      mips.emplace_back(level, PixelFormat::DXT5, false, Quality::Fast);
+      mipSizes.emplace_back(level.width(), level.height());
+      if (std::max(level.width(), level.height()) == 1) { break; }
+      level = level.reduce(Mode::Box);
+    }
+    size_t chainPixels = 0;
+    for (auto [width, height] : mipSizes) { chainPixels += size_t(width) * height; }
+
+    using TexFile = KleiLib::TexFile;
+    bench.run("texfile/serialize", entry, chainPixels, [&] {
+      TexFile(TexFile::Platform::Unknown, PixelFormat::DXT5, TexFile::TextureType::TwoD, 0, mips).writeToFile(texPath);
+    });
+
+    bench.run("texfile/stream", entry, chainPixels, [&] {
+      KleiLib::TexFileWriter writer(
+        texPath, TexFile::Platform::Unknown, PixelFormat::DXT5, TexFile::TextureType::TwoD, 0, mipSizes
+      );
+      for (const auto& mip : mips) { writer.write(mip); }
+      writer.finish();
+    });
+
+    bench.run("texfile/decode", entry, pixels, [&] { auto decoded = TexFile(texPath).decompress(); });
+
+    bench.run("texfile/decode_mapped", entry, pixels, [&] {
+      auto decoded = KleiLib::TexFileReader(texPath).decompressToImage();
+    });
+
+    // Where the time of a whole conversion goes
+    if (bench.selected("convert")) {
+      TexConverter::ConversionStats stats;
+      TexConverter::convertImageToTex(
+        pngPath, texPath, PixelFormat::DXT5, Mode::Box, TexFile::TextureType::TwoD, true, true, nullptr, nullptr,
+        &stats, Quality::Normal
+      );
+
+      std::cout << "convert " << entry.name << ": " << std::setprecision(3) << stats.totalMilliseconds << " ms\n";
+      for (size_t stage = 0; stage < stats.stages.size(); stage++) {
+        const auto& totals = stats.stages[stage];
+        if (totals.count == 0) { continue; }
+
+        std::cout << "  " << std::left << std::setw(14)
+                  << TexConverter::ConversionStats::stageName(TexConverter::ConversionStats::Stage(stage))
+                  << std::right << std::setw(10) << totals.milliseconds << " ms " << std::setw(12) << totals.bytes
+                  << " bytes\n";
+      }
+    }
+  }
+}